@@ -0,0 +1,566 @@
+# include <algorithm>
+# include <chrono>
+# include <cstdio>
+# include <cstdlib>
+# include <filesystem>
+# include <fstream>
+# include <functional>
+# include <iostream>
+# include <memory>
+# include <new>
+# include <random>
+# include <sstream>
+# include <string>
+# include <vector>
+
+# include "../DenseMatrix.H"
+# include "../SparseMatrix.H"
+# include "../Iterative/Krylov.H"
+# include "../GaussElimination/SystemGauss.H"
+# include "../GaussElimination/BatchGauss.H"
+
+# include <unistd.h>
+
+# ifdef _OPENMP
+#   include <omp.h>
+# endif
+
+
+/**------------------------------------------------------------------------------
+ *  benchmark driver :  sweeps kernels x sizes x threads and reports time ,
+ *  GFLOP/s and effective bandwidth (model bytes / time) as CSV or JSON
+ *
+ *    ./bench [--kernels gemm,matvec,...] [--sizes 128,256] [--threads 1,2,4]
+ *            [--reps 5] [--batch 10000] [--format csv|json] [--out file]
+ *
+ *    kernels      n is
+ *    gemm         order of C = A*B           (blocked kernel)
+ *    strassen     order of C = A*B           (padded Strassen)
+ *    matvec       order of A in y = A x
+ *    add          order of A in A += B
+ *    det          order of A                 (DenseMatrix::det , LU)
+ *    matdet       order of A                 (Matrix::det , the container of Gauss)
+ *    lusolve      order of A , factor + one rhs
+ *    gauss        order of A                 (Gauss<Matrix>::gauss + solve)
+ *    batch        order of each system       (BatchGauss , --batch systems , <= 256 MB)
+ *    spmv         grid side of a 5-point Laplacian  (n^2 unknowns)
+ *    cg           grid side , 50 Jacobi-CG iterations
+ *    load         order of A , text file read by DenseMatrix(file)
+ *    loadbin      order of A , binary file read by DenseMatrix(file)
+ *    loadmtx      order of A , MatrixMarket file (every entry) read by DenseMatrix(file)
+ *    loadsparse   grid side , MatrixMarket file of the 5-point Laplacian read by SparseMatrix(file)
+ *
+ *    every point is the minimum over  reps  runs after one warm-up run ;
+ *    operands updated in place (gauss , batch) are restored before each run ,
+ *    out of the timing ;  the input files of gauss and of the load cases are unique
+ *    temporary files removed at the end of their case
+ *    built with -DMG_INSTRUMENT (make instrumented) the per-kernel counters and
+ *    the heap allocations are printed at the end (on stderr)
+ *
+ ------------------------------------------------------------------------------*/
+
+using namespace mg::numeric::algebra ;
+
+
+# ifdef MG_INSTRUMENT
+// every heap allocation of the process goes through the instrumentation counters :
+// the whole replaceable set (plain , array , nothrow , aligned , sized) is replaced
+// so that AlignedVector is counted too and every new meets the matching delete ;
+// the deletes are not inlined , GCC would otherwise pair  free  with  operator new
+namespace {
+
+void* countedAlloc(std::size_t n, const std::size_t align) noexcept
+{
+   instrument::Registry::get().allocation(n) ;
+   if(n == 0) n = 1 ;
+   if(align <= alignof(std::max_align_t)) return std::malloc(n) ;
+   return std::aligned_alloc(align, (n + align - 1) / align * align) ;   // size multiple of align
+}
+
+void* countedAllocOrThrow(const std::size_t n, const std::size_t align)
+{
+   if(void* p = countedAlloc(n, align)) return p ;
+   throw std::bad_alloc{} ;
+}
+
+}
+
+void* operator new  (std::size_t n)                      { return countedAllocOrThrow(n, 0) ; }
+void* operator new[](std::size_t n)                      { return countedAllocOrThrow(n, 0) ; }
+void* operator new  (std::size_t n, std::align_val_t a)  { return countedAllocOrThrow(n, std::size_t(a)) ; }
+void* operator new[](std::size_t n, std::align_val_t a)  { return countedAllocOrThrow(n, std::size_t(a)) ; }
+
+void* operator new  (std::size_t n, const std::nothrow_t&) noexcept                     { return countedAlloc(n, 0) ; }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept                     { return countedAlloc(n, 0) ; }
+void* operator new  (std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return countedAlloc(n, std::size_t(a)) ; }
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return countedAlloc(n, std::size_t(a)) ; }
+
+[[gnu::noinline]] void operator delete  (void* p) noexcept                                   { std::free(p) ; }
+[[gnu::noinline]] void operator delete[](void* p) noexcept                                   { std::free(p) ; }
+[[gnu::noinline]] void operator delete  (void* p, std::size_t) noexcept                      { std::free(p) ; }
+[[gnu::noinline]] void operator delete[](void* p, std::size_t) noexcept                      { std::free(p) ; }
+[[gnu::noinline]] void operator delete  (void* p, std::align_val_t) noexcept                 { std::free(p) ; }
+[[gnu::noinline]] void operator delete[](void* p, std::align_val_t) noexcept                 { std::free(p) ; }
+[[gnu::noinline]] void operator delete  (void* p, std::size_t, std::align_val_t) noexcept    { std::free(p) ; }
+[[gnu::noinline]] void operator delete[](void* p, std::size_t, std::align_val_t) noexcept    { std::free(p) ; }
+[[gnu::noinline]] void operator delete  (void* p, const std::nothrow_t&) noexcept            { std::free(p) ; }
+[[gnu::noinline]] void operator delete[](void* p, const std::nothrow_t&) noexcept            { std::free(p) ; }
+[[gnu::noinline]] void operator delete  (void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p) ; }
+[[gnu::noinline]] void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p) ; }
+# endif
+
+
+struct Options {
+   std::vector<std::string> kernels { "gemm", "strassen", "matvec", "add", "det", "matdet", "lusolve",
+                                      "gauss", "batch", "spmv", "cg", "load", "loadbin", "loadmtx", "loadsparse" } ;
+   std::vector<std::size_t> sizes   { 64, 128, 256, 512 } ;
+   std::vector<int>         threads ;
+   std::size_t              reps   = 5 ;
+   std::size_t              batch  = 10000 ;
+   std::string              format = "csv" ;
+   std::string              out ;
+};
+
+
+struct Result {
+   std::string kernel ;
+   std::size_t n ;
+   int         threads ;
+   std::size_t reps ;
+   double      seconds ;
+   double      flops ;
+   double      bytes ;
+};
+
+
+// work of one run :  setup is not timed ,  run is ,  flops / bytes are the model of one run
+//   reset   restores the operands before every run (not timed)
+//   scope   state released when the case ends (temporary files)
+struct Case {
+   std::function<void()> run ;
+   std::function<void()> reset ;
+   std::shared_ptr<void> scope ;
+   double flops = 0 ;
+   double bytes = 0 ;
+};
+
+
+//---
+template <typename T>
+std::vector<T> splitList(const std::string& s)
+{
+   std::vector<T> v ;
+   std::stringstream ss(s) ;
+   std::string item ;
+   while(std::getline(ss, item, ','))
+   {
+      if(item.empty()) continue ;
+      if constexpr (std::is_same_v<T,std::string>) v.push_back(item) ;
+      else                                         v.push_back(static_cast<T>(std::stoull(item))) ;
+   }
+   return v ;
+}
+
+
+Options parse(int argc, char** argv)
+{
+   Options o ;
+   for(int i=1 ; i < argc ; i++)
+   {
+      const std::string a = argv[i] ;
+      auto next = [&]() -> std::string {
+         if(i+1 >= argc) throw std::runtime_error("Missing value after " + a) ;
+         return argv[++i] ;
+      } ;
+      if     (a == "--kernels") o.kernels = splitList<std::string>(next()) ;
+      else if(a == "--sizes")   o.sizes   = splitList<std::size_t>(next()) ;
+      else if(a == "--threads") o.threads = splitList<int>(next()) ;
+      else if(a == "--reps")    o.reps    = std::max<std::size_t>(1, std::stoull(next())) ;
+      else if(a == "--batch")   o.batch   = std::max<std::size_t>(1, std::stoull(next())) ;
+      else if(a == "--format")  o.format  = next() ;
+      else if(a == "--out")     o.out     = next() ;
+      else if(a == "--help" || a == "-h")
+      {
+         std::cout << "usage: " << argv[0] << " [--kernels k1,k2] [--sizes n1,n2] [--threads t1,t2]"
+                      " [--reps r] [--batch systems] [--format csv|json] [--out file]\n" ;
+         std::exit(0) ;
+      }
+      else throw std::runtime_error("Unknown option " + a) ;
+   }
+   if(o.format != "csv" && o.format != "json")
+   {
+      throw std::runtime_error("Format must be csv or json");
+   }
+   if(o.threads.empty())
+   {
+      int maxT = 1 ;
+# ifdef _OPENMP
+      maxT = omp_get_max_threads() ;
+# endif
+      for(int t=1 ; t < maxT ; t *= 2) o.threads.push_back(t) ;
+      o.threads.push_back(maxT) ;
+   }
+   return o ;
+}
+
+
+//---
+DenseMatrix<double> randomMatrix(std::size_t n, unsigned seed, double diag = 0.0)
+{
+   std::mt19937 g(seed) ;
+   std::uniform_real_distribution<double> d(-1.0, 1.0) ;
+   DenseMatrix<double> A(n, n) ;
+   for(std::size_t i=1 ; i <= n ; i++)
+      for(std::size_t j=1 ; j <= n ; j++)
+            A(i,j) = d(g) + (i == j ? diag : 0.0) ;
+   return A ;
+}
+
+
+// coordinates of the 5-point Laplacian of an N x N grid
+void laplacian(std::size_t N, std::vector<std::size_t>& I, std::vector<std::size_t>& J, std::vector<double>& V)
+{
+   auto add = [&](std::size_t i, std::size_t j, double v){ I.push_back(i); J.push_back(j); V.push_back(v); } ;
+
+   for(std::size_t r=0 ; r < N ; r++)
+      for(std::size_t c=0 ; c < N ; c++)
+      {
+         const std::size_t k = r*N + c ;
+         add(k, k, 4.0) ;
+         if(r > 0)   add(k, k-N, -1.0) ;
+         if(r < N-1) add(k, k+N, -1.0) ;
+         if(c > 0)   add(k, k-1, -1.0) ;
+         if(c < N-1) add(k, k+1, -1.0) ;
+      }
+}
+
+
+SparseMatrix<double> laplacian(std::size_t N)
+{
+   std::vector<std::size_t> I, J ;
+   std::vector<double> V ;
+   laplacian(N, I, J, V) ;
+   return SparseMatrix<double>(N*N, N*N, I, J, V) ;
+}
+
+
+// unique file in the temporary directory ,  removed by the destructor
+// (suffix : extension the loaders look at , e.g. ".mtx")
+class TempFile {
+
+   public:
+
+      explicit TempFile(const std::string& tag, const std::string& suffix = "")
+      {
+         std::string name = (std::filesystem::temp_directory_path() / ("mg_bench_" + tag + "_XXXXXX" + suffix)).string() ;
+         const int fd = ::mkstemps(name.data(), static_cast<int>(suffix.size())) ;
+         if(fd < 0)
+         {
+            throw OpeningFileException("Unable to create a temporary file '" + name + "'") ;
+         }
+         ::close(fd) ;
+         _name = name ;
+      }
+
+      ~TempFile() { std::remove(_name.c_str()) ; }
+
+      TempFile(const TempFile&) = delete ;
+      TempFile& operator=(const TempFile&) = delete ;
+
+      const std::string& name() const noexcept { return _name ; }
+
+   private:
+
+      std::string _name ;
+};
+
+
+std::size_t fileSize(const std::string& fname)
+{
+   std::ifstream f(fname, std::ios::binary | std::ios::ate) ;
+   return f ? static_cast<std::size_t>(f.tellg()) : 0 ;
+}
+
+
+/**
+ *  @fun  set up the operands of a kernel (shared by all the runs of a point)
+ *        the state lives in the closure of  run
+ */
+Case makeCase(const std::string& k, const std::size_t n, const Options& o)
+{
+   const double N = static_cast<double>(n) , w = sizeof(double) ;
+   Case c ;
+
+   if(k == "gemm" || k == "strassen")
+   {
+      auto A = std::make_shared<DenseMatrix<double>>(randomMatrix(n, 1)) ;
+      auto B = std::make_shared<DenseMatrix<double>>(randomMatrix(n, 2)) ;
+      A->setProductMode(k == "gemm" ? gemm::ProductMode::Blocked : gemm::ProductMode::Strassen) ;
+      c.run   = [A, B]{ DenseMatrix<double> C = (*A) * (*B) ; } ;
+      c.flops = 2*N*N*N ;
+      c.bytes = 3*N*N*w ;
+   }
+   else if(k == "matvec")
+   {
+      auto A = std::make_shared<DenseMatrix<double>>(randomMatrix(n, 1)) ;
+      auto x = std::make_shared<std::vector<double>>(n, 1.0) ;
+      auto y = std::make_shared<std::vector<double>>(n) ;
+      c.run   = [A, x, y]{ multiply(*A, *x, *y) ; } ;
+      c.flops = 2*N*N ;
+      c.bytes = (N*N + 2*N)*w ;
+   }
+   else if(k == "add")
+   {
+      auto A = std::make_shared<DenseMatrix<double>>(randomMatrix(n, 1)) ;
+      auto B = std::make_shared<DenseMatrix<double>>(randomMatrix(n, 2)) ;
+      c.run   = [A, B]{ *A += *B ; } ;
+      c.flops = N*N ;
+      c.bytes = 3*N*N*w ;
+   }
+   else if(k == "det")
+   {
+      auto A = std::make_shared<DenseMatrix<double>>(randomMatrix(n, 1)) ;
+      c.run   = [A]{ volatile double d = A->det() ; (void) d ; } ;
+      c.flops = 2.0/3.0*N*N*N ;
+      c.bytes = 2*N*N*w ;
+   }
+   else if(k == "matdet")
+   {
+      const auto R = randomMatrix(n, 1) ;
+      auto A = std::make_shared<Matrix<double>>(n, n) ;
+      for(std::size_t i=1 ; i <= n ; i++)
+         for(std::size_t j=1 ; j <= n ; j++)
+               (*A)(i,j) = R(i,j) ;
+      c.run   = [A]{ volatile double d = A->det() ; (void) d ; } ;
+      c.flops = 2.0/3.0*N*N*N ;
+      c.bytes = 2*N*N*w ;
+   }
+   else if(k == "lusolve")
+   {
+      auto A = std::make_shared<DenseMatrix<double>>(randomMatrix(n, 1)) ;
+      auto b = std::make_shared<std::vector<double>>(n, 1.0) ;
+      c.run   = [A, b]{ LUFactor<double> f{*A} ; auto x = f.solve(*b) ; (void) x ; } ;
+      c.flops = 2.0/3.0*N*N*N + 2*N*N ;
+      c.bytes = 3*N*N*w ;
+   }
+   else if(k == "gauss")
+   {
+      // Gauss reads A from file :  loaded once , gauss() works in place so
+      // every run restarts from a copy (not timed)
+      std::shared_ptr<Gauss<Matrix,double>> loaded ;
+      {
+         const TempFile f("gauss") ;
+         randomMatrix(n, 1, N).save(f.name()) ;
+         loaded = std::make_shared<Gauss<Matrix,double>>(f.name(), std::valarray<double>(1.0, n),
+                                                                  std::valarray<double>(0.0, n)) ;
+      }
+      auto g  = std::make_shared<Gauss<Matrix,double>>(*loaded) ;
+      c.reset = [g, loaded]{ *g = *loaded ; } ;
+      c.run   = [g]{
+                   g->gauss() ;
+                   auto x = g->solve() ;
+                   (void) x ;
+                } ;
+      c.flops = 2.0/3.0*N*N*N + N*N ;
+      c.bytes = 2*N*N*w ;
+   }
+   else if(k == "batch")
+   {
+      // at most 256 MB of matrices
+      const std::size_t count = std::min(o.batch, std::max<std::size_t>(BatchGauss<double>::lanes, (std::size_t(1) << 25) / (n*n))) ;
+      auto B = std::make_shared<BatchGauss<double>>(count, n) ;
+      std::mt19937 g(3) ;
+      std::uniform_real_distribution<double> d(-1.0, 1.0) ;
+      std::vector<double> a(n*n), rhs(n) ;
+      for(std::size_t s=0 ; s < count ; s++)
+      {
+         for(std::size_t i=0 ; i < n*n ; i++) a[i] = d(g) + (i % (n+1) == 0 ? N : 0.0) ;
+         for(auto& v : rhs) v = d(g) ;
+         B->setSystem(s, a.data(), rhs.data()) ;
+      }
+      // factorize works in place :  every run restarts from a fresh copy (not timed)
+      auto fresh = std::make_shared<BatchGauss<double>>(*B) ;
+      c.reset = [B, fresh]{ *B = *fresh ; } ;
+      c.run   = [B]{ B->factorize() ; B->solve() ; } ;
+      c.flops = count * (2.0/3.0*N*N*N + 2*N*N) ;
+      c.bytes = count * (2*N*N + 2*N) * w ;
+   }
+   else if(k == "spmv" || k == "cg")
+   {
+      auto A = std::make_shared<SparseMatrix<double>>(laplacian(n)) ;
+      const double rows = N*N , nnz = static_cast<double>(A->nonZeros()) ;
+      const double spmvBytes = nnz*(w + sizeof(std::size_t)) + (rows+1)*sizeof(std::size_t) + 2*rows*w ;
+      auto x = std::make_shared<std::vector<double>>(n*n, 1.0) ;
+      auto y = std::make_shared<std::vector<double>>(n*n) ;
+      if(k == "spmv")
+      {
+         c.run   = [A, x, y]{ multiply(*A, *x, *y) ; } ;
+         c.flops = 2*nnz ;
+         c.bytes = spmvBytes ;
+      }
+      else
+      {
+         auto M = std::make_shared<JacobiPreconditioner<double>>(*A) ;
+         const std::size_t it = 50 ;
+         c.run   = [A, M, x, y, it]{
+                      SolverControl<double> ctl ;
+                      ctl.maxIter = it ;
+                      ctl.tol     = 0 ;
+                      std::fill(y->begin(), y->end(), 0.0) ;
+                      cg(*A, *x, *y, *M, ctl) ;
+                   } ;
+         // per iteration : 1 spmv , 2 dot , 3 axpy-like , 1 diagonal scaling
+         c.flops = it * (2*nnz + 12*rows) ;
+         c.bytes = it * (spmvBytes + 13*rows*w) ;
+      }
+   }
+   else if(k == "load" || k == "loadbin" || k == "loadmtx")
+   {
+      auto file = std::make_shared<TempFile>(k, k == "loadmtx" ? ".mtx" : "") ;
+      const std::string fname = file->name() ;
+      const auto A = randomMatrix(n, 1) ;
+      if(k == "loadbin")
+      {
+         A.save(fname) ;
+      }
+      else
+      {
+         std::ofstream f(fname) ;
+         f.precision(17) ;
+         if(k == "loadmtx")
+         {
+            f << "%%MatrixMarket matrix coordinate real general\n" << n << ' ' << n << ' ' << n*n << '\n' ;
+            for(std::size_t i=1 ; i <= n ; i++)
+               for(std::size_t j=1 ; j <= n ; j++)
+                     f << i << ' ' << j << ' ' << A(i,j) << '\n' ;
+         }
+         else
+         {
+            for(std::size_t i=1 ; i <= n ; i++)
+            {
+               for(std::size_t j=1 ; j <= n ; j++) f << A(i,j) << ' ' ;
+               f << '\n' ;
+            }
+         }
+      }
+      c.scope = file ;
+      c.run   = [fname]{ DenseMatrix<double> B(fname) ; (void) B ; } ;
+      c.flops = 0 ;
+      c.bytes = static_cast<double>(fileSize(fname)) + N*N*w ;
+   }
+   else if(k == "loadsparse")
+   {
+      auto file = std::make_shared<TempFile>(k, ".mtx") ;
+      const std::string fname = file->name() ;
+      std::vector<std::size_t> I, J ;
+      std::vector<double> V ;
+      laplacian(n, I, J, V) ;
+      {
+         std::ofstream f(fname) ;
+         f << "%%MatrixMarket matrix coordinate real general\n" << n*n << ' ' << n*n << ' ' << V.size() << '\n' ;
+         for(std::size_t e=0 ; e < V.size() ; e++)
+               f << I[e]+1 << ' ' << J[e]+1 << ' ' << V[e] << '\n' ;
+      }
+      const double rows = N*N , nnz = static_cast<double>(V.size()) ;
+      c.scope = file ;
+      c.run   = [fname]{ SparseMatrix<double> B(fname) ; (void) B ; } ;
+      c.flops = 0 ;
+      c.bytes = static_cast<double>(fileSize(fname)) + nnz*(w + sizeof(std::size_t)) + (rows+1)*sizeof(std::size_t) ;
+   }
+   else
+   {
+      throw std::runtime_error("Unknown kernel " + k) ;
+   }
+   return c ;
+}
+
+
+double timeCase(const Case& c, const std::size_t reps)
+{
+   if(c.reset) c.reset() ;
+   c.run() ;   // warm-up (page faults , packing buffers , lazily built data)
+   double best = 1e300 ;
+   for(std::size_t r=0 ; r < reps ; r++)
+   {
+      if(c.reset) c.reset() ;
+      const auto t0 = std::chrono::steady_clock::now() ;
+      c.run() ;
+      const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0 ;
+      best = std::min(best, dt.count()) ;
+   }
+   return best ;
+}
+
+
+void write(std::ostream& os, const std::vector<Result>& res, const std::string& format)
+{
+   if(format == "csv")
+   {
+      os << "kernel,n,threads,reps,seconds,gflops,gbytes_per_s\n" ;
+      for(const auto& r : res)
+      {
+         os << r.kernel << ',' << r.n << ',' << r.threads << ',' << r.reps << ','
+            << r.seconds << ',' << r.flops / r.seconds * 1e-9 << ',' << r.bytes / r.seconds * 1e-9 << '\n' ;
+      }
+      return ;
+   }
+   os << "[" ;
+   for(std::size_t i=0 ; i < res.size() ; i++)
+   {
+      const auto& r = res[i] ;
+      os << (i ? ",\n " : "\n ") << "{\"kernel\": \"" << r.kernel << "\", \"n\": " << r.n
+         << ", \"threads\": " << r.threads << ", \"reps\": " << r.reps << ", \"seconds\": " << r.seconds
+         << ", \"gflops\": " << r.flops / r.seconds * 1e-9
+         << ", \"gbytes_per_s\": " << r.bytes / r.seconds * 1e-9 << "}" ;
+   }
+   os << "\n]\n" ;
+}
+
+
+int main(int argc, char** argv)
+{
+   try
+   {
+      const Options o = parse(argc, argv) ;
+      std::vector<Result> res ;
+
+      for(const auto& k : o.kernels)
+      {
+         for(const auto n : o.sizes)
+         {
+            const Case c = makeCase(k, n, o) ;
+            for(const int t : o.threads)
+            {
+# ifdef _OPENMP
+               omp_set_num_threads(t) ;
+# endif
+               const double s = timeCase(c, o.reps) ;
+               res.push_back({k, n, t, o.reps, s, c.flops, c.bytes}) ;
+               std::cerr << k << " n=" << n << " threads=" << t << " : " << s << " s\n" ;
+            }
+         }
+      }
+
+      if(o.out.empty())
+      {
+         write(std::cout, res, o.format) ;
+      }
+      else
+      {
+         std::ofstream f(o.out) ;
+         if(!f) throw OpeningFileException("Error opening file '" + o.out + "'") ;
+         write(f, res, o.format) ;
+      }
+
+# ifdef MG_INSTRUMENT
+      std::cerr << '\n' ;
+      instrument::report(std::cerr, o.format == "json") ;
+# endif
+   }
+   catch(const std::exception& e)
+   {
+      std::cerr << e.what() << std::endl ;
+      return 1 ;
+   }
+   return 0 ;
+}
@@ -0,0 +1,64 @@
+# include <iostream>
+# include <vector>
+# include "Krylov.H"
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+// 5-point Laplacian on a  N x N  grid  (SPD , n = N^2)
+SparseMatrix<double> poisson(std::size_t N)
+{
+   std::vector<std::size_t> I, J ;
+   std::vector<double> V ;
+   auto add = [&](std::size_t i, std::size_t j, double v){ I.push_back(i); J.push_back(j); V.push_back(v); } ;
+
+   for(std::size_t r=0 ; r < N ; r++){
+      for(std::size_t c=0 ; c < N ; c++){
+         const std::size_t k = r*N + c ;
+         add(k, k, 4.0) ;
+         if(r > 0)   add(k, k-N, -1.0) ;
+         if(r < N-1) add(k, k+N, -1.0) ;
+         if(c > 0)   add(k, k-1, -1.0) ;
+         if(c < N-1) add(k, k+1, -1.0) ;
+      }
+   }
+   return SparseMatrix<double>(N*N, N*N, I, J, V) ;
+}
+
+
+void report(const std::string& name, const SolverInfo<double>& info)
+{
+   cout << setw(22) << name << " : " << (info.converged ? "converged" : "NOT converged")
+        << " in " << setw(5) << info.iterations << " it.  |r|/|b| = " << info.residual << endl;
+}
+
+
+int main(){
+
+  const std::size_t N = 64 ;
+  SparseMatrix<double> A = poisson(N) ;
+  std::vector<double> b(A.size1(), 1.0) ;
+
+  SolverControl<double> ctl ;
+  ctl.tol = 1.0e-8 ;
+
+  JacobiPreconditioner<double> jacobi(A) ;
+  ILU0Preconditioner<double>   ilu(A) ;
+
+  std::vector<double> x ;
+
+  x.clear() ; report("CG"              , cg(A, b, x, IdentityPreconditioner{}, ctl)) ;
+  x.clear() ; report("CG + Jacobi"     , cg(A, b, x, jacobi, ctl)) ;
+  x.clear() ; report("CG + ILU(0)"     , cg(A, b, x, ilu, ctl)) ;
+  x.clear() ; report("BiCGSTAB + ILU(0)", bicgstab(A, b, x, ilu, ctl)) ;
+  x.clear() ; report("GMRES(30) + ILU(0)", gmres(A, b, x, ilu, ctl)) ;
+
+  // matrix-free operator : the same Laplacian as a lambda
+  auto op = [&A](const std::vector<double>& v, std::vector<double>& y){ multiply(A, v, y) ; } ;
+  x.clear() ; report("GMRES(30) lambda"  , gmres(op, b, x, IdentityPreconditioner{}, ctl)) ;
+
+  return 0;
+}
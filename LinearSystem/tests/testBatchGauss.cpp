@@ -0,0 +1,142 @@
+# include <cmath>
+# include <random>
+# include <vector>
+# include "../DenseMatrix.H"
+# include "../FixedMatrix.H"
+# include "../GaussElimination/BatchGauss.H"
+# include "Check.H"
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+// max over the systems of  max_i |(A_s x_s - b_s)_i|
+template <typename T>
+double maxResidual(const BatchGauss<T>& g, const std::vector<T>& A, const std::vector<T>& b,
+                   const std::size_t count, const std::size_t n)
+{
+   double r = 0 ;
+   for(std::size_t s=0 ; s < count ; s++)
+   {
+      const T* x = g.solution(s) ;
+      for(std::size_t i=0 ; i < n ; i++)
+      {
+         double v = -double(b[s*n + i]) ;
+         for(std::size_t j=0 ; j < n ; j++)
+               v += double(A[(s*n + i)*n + j]) * double(x[j]) ;
+         r = std::max(r, std::abs(v)) ;
+      }
+   }
+   return r ;
+}
+
+
+// count random diagonally dominant systems (count not a multiple of the lanes : padded last pack)
+template <typename T>
+void randomBatch(const std::size_t count, const std::size_t n, const double tol)
+{
+   std::mt19937 g(unsigned(count + n)) ;
+   std::uniform_real_distribution<T> d(-1.0, 1.0) ;
+   std::vector<T> A(count*n*n) , b(count*n) ;
+   for(auto& v : A) v = d(g) ;
+   for(auto& v : b) v = d(g) ;
+   for(std::size_t s=0 ; s < count ; s++)
+      for(std::size_t i=0 ; i < n ; i++)
+            A[(s*n + i)*n + i] += T(n) ;
+
+   BatchGauss<T> batch(count, n) ;
+   for(std::size_t s=0 ; s < count ; s++) batch.setSystem(s, &A[s*n*n], &b[s*n]) ;
+   batch.solve() ;
+
+   bool singular = false ;
+   for(std::size_t s=0 ; s < count ; s++) singular = singular || batch.isSingular(s) ;
+
+   const std::string what = std::to_string(count) + " systems " + std::to_string(n) + "x" + std::to_string(n) +
+                            (sizeof(T) == 8 ? " (double)" : " (float)") ;
+   check(what + " residual", !singular && maxResidual(batch, A, b, count, n) < tol) ;
+
+   // new right hand sides on the same factors
+   for(auto& v : b) v = d(g) ;
+   for(std::size_t s=0 ; s < count ; s++)
+      for(std::size_t i=1 ; i <= n ; i++)
+            batch.b(s,i) = b[s*n + i-1] ;
+   batch.solve() ;
+   check(what + " new rhs", maxResidual(batch, A, b, count, n) < tol) ;
+}
+
+
+int main(){
+
+  randomBatch<double>(1, 1, 1e-13) ;
+  randomBatch<double>(13, 3, 1e-13) ;
+  randomBatch<double>(1000, 8, 1e-12) ;
+  randomBatch<double>(101, 17, 1e-12) ;
+  randomBatch<float>(37, 6, 1e-4) ;
+
+  // pivoting in each lane :  the zero leading pivot needs a row swap ,  x = (1 2 3)
+  // system s is the same system with rows rotated by s
+  {
+     const DenseMatrix<double> a{ { 0,  1, 1} ,
+                                  { 4, -6, 0} ,
+                                  {-2,  7, 2} } ;
+     const std::vector<double> x{1, 2, 3} ;
+     const std::size_t count = 11 ;
+     BatchGauss<double> batch(count, 3) ;
+     for(std::size_t s=0 ; s < count ; s++)
+     {
+        DenseMatrix<double> r(3, 3) ;
+        std::vector<double> rhs(3) ;
+        for(std::size_t i=1 ; i <= 3 ; i++)
+        {
+           const std::size_t k = (i - 1 + s) % 3 + 1 ;
+           for(std::size_t j=1 ; j <= 3 ; j++) r(i,j) = a(k,j) ;
+           rhs[i-1] = a(k,1)*x[0] + a(k,2)*x[1] + a(k,3)*x[2] ;
+        }
+        batch.setSystem(s, r, rhs) ;
+     }
+     const auto& y = batch.solve() ;
+     double m = 0 ;
+     for(std::size_t s=0 ; s < count ; s++)
+        for(std::size_t i=0 ; i < 3 ; i++)
+              m = std::max(m, std::abs(y[s*3 + i] - x[i])) ;
+     check("row swaps in every lane", y.size() == count*3 && m < 1e-13) ;
+  }
+
+  // a singular system does not spoil the others
+  {
+     const std::size_t count = 10 ;
+     BatchGauss<double> batch(count, 2) ;
+     for(std::size_t s=0 ; s < count ; s++)
+     {
+        const FixedMatrix<double,2,2> a{ {2, 1} , {1, 3} } ;
+        batch.setSystem(s, a, std::vector<double>{3, 4}) ;
+     }
+     const FixedMatrix<double,2,2> s{ {1, 2} , {2, 4} } ;
+     batch.setSystem(4, s, std::vector<double>{1, 1}) ;
+     batch.solve() ;
+
+     bool others = true ;
+     for(std::size_t k=0 ; k < count ; k++)
+        if(k != 4)
+           others = others && !batch.isSingular(k) &&
+                    std::abs(batch.solution(k)[0] - 1) < 1e-14 && std::abs(batch.solution(k)[1] - 1) < 1e-14 ;
+     check("singular system flagged", batch.isSingular(4) && !std::isfinite(batch.solution(4)[1])) ;
+     check("the other systems are solved", others) ;
+  }
+
+  // sizes
+  {
+     check("0 equations throws InvalidSizeException",
+           throws<InvalidSizeException>([]{ BatchGauss<double>(4, 0) ; })) ;
+     BatchGauss<double> batch(4, 3) ;
+     check("system of the wrong size throws InvalidSizeException",
+           throws<InvalidSizeException>([&]{ batch.setSystem(0, DenseMatrix<double>(2, 2), std::vector<double>(2)) ; })) ;
+     check("rhs of the wrong size throws InvalidSizeException",
+           throws<InvalidSizeException>([&]{ batch.setSystem(0, DenseMatrix<double>(3, 3), std::vector<double>(2)) ; })) ;
+     check("empty batch", BatchGauss<double>(0, 3).solve().empty()) ;
+  }
+
+  return checkSummary("BatchGauss") ;
+}
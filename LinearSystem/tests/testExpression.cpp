@@ -0,0 +1,130 @@
+# include <utility>
+# include "../DenseMatrix.H"
+# include "Check.H"
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+DenseMatrix<double> ramp(std::size_t r, std::size_t c, double base)
+{
+   DenseMatrix<double> a(r, c) ;
+   for(std::size_t i=1 ; i <= r ; i++)
+      for(std::size_t j=1 ; j <= c ; j++)
+            a(i,j) = base + 10.0*i + j ;
+   return a ;
+}
+
+
+bool equal(const DenseMatrix<double>& a, const DenseMatrix<double>& b)
+{
+   if(a.size1() != b.size1() || a.size2() != b.size2()) return false ;
+   for(std::size_t i=1 ; i <= a.size1() ; i++)
+      for(std::size_t j=1 ; j <= a.size2() ; j++)
+            if(a(i,j) != b(i,j)) return false ;
+   return true ;
+}
+
+
+int main(){
+
+  const auto A = ramp(4, 5, 0.0) , B = ramp(4, 5, 100.0) , D = ramp(4, 5, -3.0) ;
+
+  // fused expression against the element-wise loop
+  {
+     const DenseMatrix<double> C = A*2.0 + B - D/4.0 ;
+     DenseMatrix<double> R(4, 5) ;
+     for(std::size_t i=1 ; i <= 4 ; i++)
+        for(std::size_t j=1 ; j <= 5 ; j++)
+              R(i,j) = A(i,j)*2.0 + B(i,j) - D(i,j)/4.0 ;
+     check("A*2 + B - D/4", equal(C, R)) ;
+  }
+
+  check("size mismatch throws InvalidSizeException",
+        throws<InvalidSizeException>([&]{ DenseMatrix<double> C = A + ramp(5, 4, 0.0) ; })) ;
+
+  // destination read in place (element to same element) : no temporary needed
+  {
+     DenseMatrix<double> C{A} ;
+     C = C*3.0 - A ;
+     check("C = C*3 - A", equal(C, A*2.0)) ;
+  }
+
+  // view of the destination in the source : overlapping shifted blocks
+  {
+     DenseMatrix<double> C{A} , R{A} ;
+     C.block(1,2,4,4) = C.block(1,1,4,4) + B.block(1,1,4,4) ;
+     const DenseMatrix<double> old{A} ;
+     for(std::size_t i=1 ; i <= 4 ; i++)
+        for(std::size_t j=2 ; j <= 5 ; j++)
+              R(i,j) = old(i,j-1) + B(i,j-1) ;
+     check("overlapping view assignment C[:,2:5] = C[:,1:4] + B", equal(C, R)) ;
+  }
+  {
+     DenseMatrix<double> C{A} ;
+     C = C.block(2,2,2,3) * 2.0 ;
+     DenseMatrix<double> R(2, 3) ;
+     for(std::size_t i=1 ; i <= 2 ; i++)
+        for(std::size_t j=1 ; j <= 3 ; j++)
+              R(i,j) = A(i+1,j+1) * 2.0 ;
+     check("C = 2 * (view of C) with a resize", equal(C, R)) ;
+  }
+
+  // writes through a view change the matrix only inside the block
+  {
+     DenseMatrix<double> C(4, 5) ;
+     C.block(2,3,2,2) = A.block(1,1,2,2) ;
+     bool ok = true ;
+     for(std::size_t i=1 ; i <= 4 ; i++)
+        for(std::size_t j=1 ; j <= 5 ; j++)
+        {
+           const bool in = i >= 2 && i <= 3 && j >= 3 && j <= 4 ;
+           ok = ok && C(i,j) == (in ? A(i-1,j-2) : 0.0) ;
+        }
+     check("block assignment", ok) ;
+     check("block out of range throws InvalidSizeException",
+           throws<InvalidSizeException>([&]{ C.block(4,5,2,1) ; })) ;
+  }
+
+  // empty views
+  {
+     DenseMatrix<double> C{A} ;
+     C.block(1,1,0,3) = B.block(1,1,0,3) ;
+     C.block(2,2,3,0) = B.block(2,2,3,0) * 2.0 ;
+     check("assignment of empty views is a no-op", equal(C, A)) ;
+  }
+
+  // minors : owning copy and lazy view
+  {
+     auto m = ramp(3, 3, 0.0).minors(2,2) ;     // temporary source : m must own its data
+     DenseMatrix<double> R{ {11, 13} ,
+                            {31, 33} } ;
+     check("minors() returns an owning DenseMatrix", equal(m, R)) ;
+
+     const auto S = ramp(3, 3, 0.0) ;
+     const DenseMatrix<double> v = S.minorView(1,3) + S.minorView(1,3) ;
+     DenseMatrix<double> V{ {42, 44} ,
+                            {62, 64} } ;
+     check("minorView() in an expression", equal(v, V)) ;
+     check("exctractMinor() of a non-square matrix throws InvalidSizeException",
+           throws<InvalidSizeException>([&]{ A.exctractMinor(1,1) ; })) ;
+  }
+
+  // move semantics and the Strassen leaf size
+  {
+     DenseMatrix<double> C{A} ;
+     C.setLeafSize(32) ;
+     DenseMatrix<double> M{std::move(C)} ;
+     check("move constructor steals the data", equal(M, A) && C.size1() == 0 && C.size2() == 0) ;
+
+     DenseMatrix<double> X(2, 2) , Y(2, 2) ;
+     X = M ;
+     Y = std::move(M) ;
+     check("copy / move assignment keep the leaf size", X.getLeafSize() == 32 && Y.getLeafSize() == 32) ;
+     check("move assignment steals the data", equal(Y, A) && M.size1() == 0) ;
+  }
+
+  return checkSummary("expressions / views") ;
+}
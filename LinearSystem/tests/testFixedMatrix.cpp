@@ -0,0 +1,130 @@
+# include <cmath>
+# include <random>
+# include "../FixedMatrix.H"
+# include "../LUFactor.H"
+# include "Check.H"
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+// computed by the compiler : closed forms and the unrolled LU
+constexpr FixedMatrix<double,2,2> J2{ {2.0, 1.0} ,
+                                      {1.0, 3.0} } ;
+static_assert(det(J2) == 5.0) ;
+static_assert(inverse(FixedMatrix<double,2,2>{ {2.0, 1.0} , {0.0, 4.0} }) ==
+              FixedMatrix<double,2,2>{ {0.5, -0.125} , {0.0, 0.25} }) ;
+
+constexpr FixedMatrix<double,3,3> J3{ {2.0, 0.0, 0.0} ,
+                                      {0.0, 4.0, 0.0} ,
+                                      {1.0, 0.0, 8.0} } ;
+static_assert(det(J3) == 64.0) ;
+
+// 4x4 :  the zero leading pivot forces a row swap ,  every step is exact in binary
+constexpr FixedMatrix<double,4,4> J4{ {0.0, 2.0, 0.0, 0.0} ,
+                                      {4.0, 0.0, 0.0, 0.0} ,
+                                      {0.0, 0.0, 0.0, 0.5} ,
+                                      {0.0, 0.0, 8.0, 0.0} } ;
+static_assert(det(J4) == 32.0) ;
+static_assert(inverse(J4) * J4 == FixedMatrix<double,4,4>::identity()) ;
+static_assert(solve(J4, FixedVector<double,4>{ {2.0}, {4.0}, {1.0}, {8.0} }) ==
+              FixedVector<double,4>{ {1.0}, {1.0}, {1.0}, {2.0} }) ;
+
+
+
+template <std::size_t N>
+FixedMatrix<double,N,N> random(unsigned seed)
+{
+   std::mt19937 g(seed) ;
+   std::uniform_real_distribution<double> d(-1.0, 1.0) ;
+   FixedMatrix<double,N,N> a ;
+   for(std::size_t i=1 ; i <= N ; i++)
+      for(std::size_t j=1 ; j <= N ; j++)
+            a(i,j) = d(g) ;
+   return a ;
+}
+
+
+template <std::size_t R, std::size_t C>
+double maxDiff(const FixedMatrix<double,R,C>& a, const FixedMatrix<double,R,C>& b)
+{
+   double m = 0 ;
+   for(std::size_t i=1 ; i <= R ; i++)
+      for(std::size_t j=1 ; j <= C ; j++)
+            m = std::max(m, std::abs(a(i,j) - b(i,j))) ;
+   return m ;
+}
+
+
+// det , inverse and solve of a random N x N against the DenseMatrix / LUFactor path
+template <std::size_t N>
+void against(unsigned seed)
+{
+   const std::string n = std::to_string(N) + "x" + std::to_string(N) ;
+   const auto a = random<N>(seed) ;
+   auto d = a.toDense() ;
+   const double ref = d.det() ;
+   check(n + " det", std::abs(det(a) - ref) <= 1e-12 * std::max(1.0, std::abs(ref))) ;
+
+   check(n + " inverse", maxDiff(inverse(a) * a, FixedMatrix<double,N,N>::identity()) < 1e-10) ;
+
+   FixedMatrix<double,N,2> b ;
+   for(std::size_t i=1 ; i <= N ; i++) { b(i,1) = double(i) ; b(i,2) = 1.0 / i ; }
+   const auto x = solve(a, b) ;
+   check(n + " solve (2 rhs)", maxDiff(a * x, b) < 1e-10) ;
+
+   std::vector<double> rhs(N) ;
+   for(std::size_t i=1 ; i <= N ; i++) rhs[i-1] = double(i) ;
+   const auto y = LUFactor<double>{d}.solve(rhs) ;
+   double m = 0 ;
+   for(std::size_t i=1 ; i <= N ; i++) m = std::max(m, std::abs(x(i,1) - y[i-1])) ;
+   check(n + " solve = LUFactor", m < 1e-10) ;
+}
+
+
+int main(){
+
+  against<1>(1) ;
+  against<2>(2) ;
+  against<3>(3) ;
+  against<4>(4) ;
+  against<5>(5) ;
+  against<6>(6) ;
+  against<8>(8) ;
+
+  // product and transpose against DenseMatrix
+  {
+     const auto a = random<3>(10) ;
+     FixedMatrix<double,3,2> b{ {1, 2} , {3, 4} , {5, 6} } ;
+     const auto c = a * b ;
+     const auto ref = a.toDense() * b.toDense() ;
+     double m = 0 ;
+     for(std::size_t i=1 ; i <= 3 ; i++)
+        for(std::size_t j=1 ; j <= 2 ; j++)
+              m = std::max(m, std::abs(c(i,j) - ref(i,j))) ;
+     check("3x3 * 3x2 = DenseMatrix product", m < 1e-14) ;
+     check("transpose", transpose(transpose(b)) == b && transpose(b)(2,3) == 6) ;
+     check("DenseMatrix round trip", FixedMatrix<double,3,3>(a.toDense()) == a) ;
+  }
+
+  // singular matrices (run time) and sizes
+  {
+     FixedMatrix<double,2,2> s2{ {1, 2} , {2, 4} } ;
+     FixedMatrix<double,5,5> s5 = random<5>(11) ;
+     for(std::size_t j=1 ; j <= 5 ; j++) s5(5,j) = 0.0 ;
+     check("2x2 singular : det = 0", det(s2) == 0.0) ;
+     check("5x5 singular : det = 0", det(s5) == 0.0) ;
+     check("2x2 singular inverse throws MatrixException", throws<MatrixException>([&]{ inverse(s2) ; })) ;
+     check("5x5 singular inverse throws MatrixException", throws<MatrixException>([&]{ inverse(s5) ; })) ;
+     check("5x5 singular solve throws MatrixException",
+           throws<MatrixException>([&]{ solve(s5, FixedVector<double,5>{}) ; })) ;
+     check("DenseMatrix of the wrong size throws InvalidSizeException",
+           throws<InvalidSizeException>([]{ FixedMatrix<double,2,2>(DenseMatrix<double>(2, 3)) ; })) ;
+     check("initializer with too many rows throws InvalidSizeException",
+           throws<InvalidSizeException>([]{ FixedMatrix<double,2,2>{ {1} , {2} , {3} } ; })) ;
+  }
+
+  return checkSummary("FixedMatrix") ;
+}
@@ -0,0 +1,131 @@
+# include <cmath>
+# include <limits>
+# include <random>
+# include "../DenseMatrix.H"
+# include "Check.H"
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+DenseMatrix<double> random(std::size_t r, std::size_t c, unsigned seed)
+{
+   std::mt19937 g(seed) ;
+   std::uniform_real_distribution<double> d(-1.0, 1.0) ;
+   DenseMatrix<double> a(r, c) ;
+   for(std::size_t i=1 ; i <= r ; i++)
+      for(std::size_t j=1 ; j <= c ; j++)
+            a(i,j) = d(g) ;
+   return a ;
+}
+
+
+// C = A*B by the plain ijk loop and  |A||B|  (element-wise bound of the rounding)
+void reference(const DenseMatrix<double>& a, const DenseMatrix<double>& b,
+               DenseMatrix<double>& c, DenseMatrix<double>& abs)
+{
+   for(std::size_t i=1 ; i <= a.size1() ; i++)
+      for(std::size_t j=1 ; j <= b.size2() ; j++)
+      {
+         double s = 0 , t = 0 ;
+         for(std::size_t k=1 ; k <= a.size2() ; k++)
+         {
+            s += a(i,k) * b(k,j) ;
+            t += std::abs(a(i,k)) * std::abs(b(k,j)) ;
+         }
+         c(i,j) = s ;
+         abs(i,j) = t ;
+      }
+}
+
+
+// blocked kernel :  |C - C_ijk| <= 2 K eps |A||B|  element-wise
+void blocked(std::size_t m, std::size_t k, std::size_t n)
+{
+   const auto a = random(m, k, 1) , b = random(k, n, 2) ;
+   DenseMatrix<double> ref(m, n) , abs(m, n) ;
+   reference(a, b, ref, abs) ;
+
+   const DenseMatrix<double> c = a * b ;
+   const double eps = std::numeric_limits<double>::epsilon() ;
+   bool ok = c.size1() == m && c.size2() == n ;
+   for(std::size_t i=1 ; ok && i <= m ; i++)
+      for(std::size_t j=1 ; j <= n ; j++)
+            ok = ok && std::abs(c(i,j) - ref(i,j)) <= 2.0 * k * eps * abs(i,j) ;
+
+   check("blocked " + to_string(m) + "x" + to_string(k) + " * " + to_string(k) + "x" + to_string(n), ok) ;
+}
+
+
+// Strassen :  |C - C_ijk| <= (2 leaf + 5 n) 12^levels eps ||A|| ||B||   (max-norm , n padded order)
+void strassenProduct(std::size_t m, std::size_t k, std::size_t n, std::size_t leaf)
+{
+   auto a = random(m, k, 3) ;
+   const auto b = random(k, n, 4) ;
+   a.setLeafSize(leaf) ;
+   a.setProductMode(gemm::ProductMode::Strassen) ;
+   DenseMatrix<double> ref(m, n) , abs(m, n) ;
+   reference(a, b, ref, abs) ;
+
+   const DenseMatrix<double> c = a * b ;
+
+   std::size_t p = std::max({m, k, n}) , levels = 0 ;
+   while(p > leaf) { p = (p + 1) / 2 ; levels++ ; }
+   p <<= levels ;
+
+   double normA = 0 , normB = 0 , err = 0 ;
+   for(std::size_t i=1 ; i <= m ; i++) for(std::size_t j=1 ; j <= k ; j++) normA = std::max(normA, std::abs(a(i,j))) ;
+   for(std::size_t i=1 ; i <= k ; i++) for(std::size_t j=1 ; j <= n ; j++) normB = std::max(normB, std::abs(b(i,j))) ;
+   for(std::size_t i=1 ; i <= m ; i++) for(std::size_t j=1 ; j <= n ; j++) err = std::max(err, std::abs(c(i,j) - ref(i,j))) ;
+
+   const double bound = (2.0*leaf + 5.0*p) * std::pow(12.0, levels) *
+                        std::numeric_limits<double>::epsilon() * normA * normB ;
+
+   check("strassen " + to_string(m) + "x" + to_string(k) + " * " + to_string(k) + "x" + to_string(n) +
+         " leaf " + to_string(leaf) + " (" + to_string(levels) + " levels)", err <= bound && c.size1() == m && c.size2() == n) ;
+}
+
+
+int main(){
+
+  // edge cases and sizes across the register tile (4x8) and cache blocks (MC 128 , KC 256)
+  blocked(1, 1, 1) ;
+  blocked(3, 5, 7) ;
+  blocked(4, 8, 8) ;
+  blocked(37, 300, 41) ;
+  blocked(130, 257, 129) ;
+  blocked(61, 300, 517) ;      // one ic-block on a team : the jr panels are shared out
+  blocked(7, 9, 11) ;          // smaller again :  the packing buffers are reused
+
+  strassenProduct(64, 64, 64, 16) ;
+  strassenProduct(100, 70, 90, 16) ;     // zero padding to 128
+  strassenProduct(200, 200, 200, 32) ;
+
+  // leaf larger than the matrix : blocked kernel , same result
+  {
+     auto a = random(50, 50, 5) ;
+     const auto b = random(50, 50, 6) ;
+     const DenseMatrix<double> c1 = a * b ;
+     a.setProductMode(gemm::ProductMode::Strassen) ;
+     const DenseMatrix<double> c2 = a * b ;
+     bool same = true ;
+     for(std::size_t i=1 ; i <= 50 ; i++) for(std::size_t j=1 ; j <= 50 ; j++) same = same && c1(i,j) == c2(i,j) ;
+     check("strassen below the leaf size falls back to the blocked kernel", same) ;
+  }
+
+  // the mode belongs to the matrix :  copied with it , other matrices unchanged
+  {
+     auto a = random(4, 4, 7) ;
+     a.setProductMode(gemm::ProductMode::Strassen) ;
+     const DenseMatrix<double> copy = a , other = random(4, 4, 8) ;
+     check("product mode : per matrix , copied",
+           copy.getProductMode() == gemm::ProductMode::Strassen && other.getProductMode() == gemm::ProductMode::Blocked) ;
+  }
+
+  check("size mismatch throws InvalidSizeException",
+        throws<InvalidSizeException>([]{ DenseMatrix<double> c = random(3, 4, 1) * random(3, 4, 2) ; })) ;
+
+  return checkSummary("gemm / strassen") ;
+}
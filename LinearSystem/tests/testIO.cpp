@@ -0,0 +1,249 @@
+# include <cmath>
+# include <cstdint>
+# include <cstdio>
+# include <filesystem>
+# include <fstream>
+# include <random>
+# include <string>
+# include <vector>
+# include "../DenseMatrix.H"
+# include "../MappedMatrix.H"
+# include "Check.H"
+
+# ifdef _OPENMP
+#   include <omp.h>
+# endif
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+// fixture files of this program ,  removed at the end
+const std::string tmp = "testIO_tmp" ;
+
+void write(const std::string& fname, const std::string& text)
+{
+   std::ofstream f(fname, std::ios::out | std::ios::binary | std::ios::trunc) ;
+   f << text ;
+}
+
+
+template <typename M>
+bool equals(const M& a, const std::vector<double>& v, std::size_t rows, std::size_t cols)
+{
+   if(a.size1() != rows || a.size2() != cols) return false ;
+   for(std::size_t i=1 ; i <= rows ; i++)
+      for(std::size_t j=1 ; j <= cols ; j++)
+            if(a(i,j) != v[(i-1)*cols + j-1]) return false ;
+   return true ;
+}
+
+
+// patch the header of a binary file
+template <typename F>
+void patchHeader(const std::string& fname, F&& f)
+{
+   std::fstream s(fname, std::ios::in | std::ios::out | std::ios::binary) ;
+   io::BinaryHeader h ;
+   s.read(reinterpret_cast<char*>(&h), sizeof(h)) ;
+   f(h) ;
+   s.seekp(0) ;
+   s.write(reinterpret_cast<const char*>(&h), sizeof(h)) ;
+}
+
+
+int main(){
+
+# ifdef _OPENMP
+  omp_set_num_threads(4) ;         // 16 chunks for the large files
+# endif
+
+  // plain text : blanks , tabs , commas , CRLF , empty lines , leading '+'
+  {
+     const std::string f = tmp + ".dat" ;
+     write(f, "\n1 2.5\t-3\r\n\n  4,+5 , 6e-1\n7 8 9") ;
+     const std::vector<double> ref{1, 2.5, -3, 4, 5, 0.6, 7, 8, 9} ;
+     std::size_t r , c ;
+     std::vector<double> d ;
+     io::readDense(f, r, c, d) ;
+     check("text : separators and empty lines", r == 3 && c == 3 && d == ref) ;
+     check("text : DenseMatrix(file)", equals(DenseMatrix<double>(f), ref, 3, 3)) ;
+     check("text : Matrix(file)", equals(Matrix<double>(f), ref, 3, 3)) ;
+
+     write(f, "1 2 3\n4 5\n") ;
+     check("text : ragged rows throw InvalidSizeException",
+           throws<InvalidSizeException>([&]{ io::readDense(f, r, c, d) ; })) ;
+
+     write(f, "1 2\n4-5 6\n") ;
+     check("text : 4-5 is one bad token , not two values",
+           throws<OpeningFileException>([&]{ io::readDense(f, r, c, d) ; })) ;
+
+     write(f, "1 2\n3 x\n") ;
+     check("text : bad value throws OpeningFileException",
+           throws<OpeningFileException>([&]{ io::readDense(f, r, c, d) ; })) ;
+
+     check("missing file throws OpeningFileException",
+           throws<OpeningFileException>([&]{ io::readDense(tmp + "_none.dat", r, c, d) ; })) ;
+  }
+
+  // large text file :  many chunks ,  the even cut points fall inside the values
+  {
+     const std::string f = tmp + "_large.dat" ;
+     const std::size_t rows = 3001 , cols = 17 ;
+     std::mt19937 g(7) ;
+     std::uniform_real_distribution<double> u(-1.0, 1.0) ;
+     std::vector<double> ref(rows*cols) ;
+     {
+        std::ofstream s(f) ;
+        s.precision(17) ;
+        for(std::size_t i=0 ; i < rows ; i++)
+        {
+           for(std::size_t j=0 ; j < cols ; j++)
+           {
+              // widths from 1 to 24 characters
+              ref[i*cols + j] = (j % 3 == 0) ? double(i % 10) : u(g) * std::pow(10.0, double(j % 7)) ;
+              s << ref[i*cols + j] << (j + 1 < cols ? " " : "\n") ;
+           }
+        }
+     }
+
+     io::MappedFile m(f) ;
+     const std::size_t parts = 16 ;
+     const auto cut = io::splitLines(m.begin(), m.end(), parts) ;
+     bool lines = cut.size() == parts + 1 && cut.front() == m.begin() && cut.back() == m.end() ;
+     std::size_t inside = 0 ;
+     for(std::size_t t=1 ; t < parts ; t++)
+     {
+        lines = lines && cut[t][-1] == '\n' ;
+        const char* even = m.begin() + m.size() * t / parts ;
+        inside += even[-1] != '\n' && even[-1] != ' ' && *even != ' ' && *even != '\n' ;
+     }
+     check("splitLines : every inner cut is after a newline", lines) ;
+     check("fixture : some even cuts straddle a value (" + std::to_string(inside) + ")", inside > 0) ;
+
+     std::size_t r , c ;
+     std::vector<double> d ;
+     io::readDense(m, f, r, c, d) ;
+     check("text : 2-pass chunked parse is exact", r == rows && c == cols && d == ref) ;
+
+     // a bad token and a short row in a late chunk
+     std::string text ;
+     {
+        std::ifstream s(f) ;
+        text.assign(std::istreambuf_iterator<char>(s), std::istreambuf_iterator<char>()) ;
+     }
+     std::string bad = text ;
+     bad[bad.find_last_of("0123456789", bad.size() - 40)] = 'x' ;
+     write(f, bad) ;
+     check("text : bad token in a late chunk throws",
+           throws<MatrixException>([&]{ io::readDense(f, r, c, d) ; })) ;
+     write(f, text + "1 2 3\n") ;
+     check("text : short last row throws InvalidSizeException",
+           throws<InvalidSizeException>([&]{ io::readDense(f, r, c, d) ; })) ;
+     std::remove(f.c_str()) ;
+  }
+
+  // MatrixMarket
+  {
+     const std::string f = tmp + ".mtx" ;
+     write(f, "%%MatrixMarket matrix coordinate real symmetric\n"
+              "% comment\n"
+              "3 3 4\n"
+              "1 1 2.0\n"
+              "3 1 -1.0\n"
+              "% comment between entries\n"
+              "2 2 4.0\n"
+              "3 3 1.5\n") ;
+     const auto c = io::readMatrixMarket<double>(f) ;
+     check("mtx : banner and entries", c.rows == 3 && c.cols == 3 && c.symmetric && c.I.size() == 4) ;
+     check("mtx : symmetric expanded by DenseMatrix(file)",
+           equals(DenseMatrix<double>(f), {2, 0, -1 , 0, 4, 0 , -1, 0, 1.5}, 3, 3)) ;
+
+     write(f, "%%MatrixMarket matrix coordinate integer skew-symmetric\n2 2 1\n2 1 3\n") ;
+     check("mtx : skew-symmetric", equals(DenseMatrix<double>(f), {0, -3 , 3, 0}, 2, 2)) ;
+
+     write(f, "%%MatrixMarket matrix coordinate pattern general\n2 3 2\n1 3\n2 1\n") ;
+     check("mtx : pattern", equals(DenseMatrix<double>(f), {0, 0, 1 , 1, 0, 0}, 2, 3)) ;
+
+     write(f, "%%MatrixMarket matrix coordinate complex general\n2 2 1\n1 1 1.0 2.0\n") ;
+     check("mtx : complex field throws OpeningFileException",
+           throws<OpeningFileException>([&]{ io::readMatrixMarket<double>(f) ; })) ;
+
+     write(f, "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n") ;
+     check("mtx : array format throws OpeningFileException",
+           throws<OpeningFileException>([&]{ io::readMatrixMarket<double>(f) ; })) ;
+
+     write(f, "%%MatrixMarket matrix coordinate real general\n2 2 3\n1 1 1\n2 2 1\n") ;
+     check("mtx : wrong entry count throws InvalidSizeException",
+           throws<InvalidSizeException>([&]{ io::readMatrixMarket<double>(f) ; })) ;
+
+     write(f, "%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n") ;
+     check("mtx : entry out of range throws InvalidCoordinateException",
+           throws<InvalidCoordinateException>([&]{ io::readMatrixMarket<double>(f) ; })) ;
+     std::remove(f.c_str()) ;
+  }
+
+  // binary : save / load round trip , column-major load , header checks
+  {
+     const std::string f = tmp + ".bin" ;
+     const std::size_t rows = 5 , cols = 3 ;
+     DenseMatrix<double> a(rows, cols) ;
+     std::vector<double> ref(rows*cols) ;
+     for(std::size_t i=1 ; i <= rows ; i++)
+        for(std::size_t j=1 ; j <= cols ; j++)
+              a(i,j) = ref[(i-1)*cols + j-1] = 1.0 / (i + 2.0*j) ;
+
+     a.save(f) ;
+     check("binary : size = header + values", std::filesystem::file_size(f) == sizeof(io::BinaryHeader) + rows*cols*sizeof(double)) ;
+     check("binary : DenseMatrix save / load round trip", equals(DenseMatrix<double>(f), ref, rows, cols)) ;
+     check("binary : Matrix(file)", equals(Matrix<double>(f), ref, rows, cols)) ;
+     check("binary : other value type throws OpeningFileException",
+           throws<OpeningFileException>([&]{ DenseMatrix<float> b(f) ; })) ;
+
+     // the same values stored column by column
+     std::vector<double> colMajor(rows*cols) ;
+     for(std::size_t i=0 ; i < rows ; i++)
+        for(std::size_t j=0 ; j < cols ; j++)
+              colMajor[j*rows + i] = ref[i*cols + j] ;
+     const std::string fc = tmp + "_col.bin" ;
+     io::writeBinary(fc, rows, cols, colMajor.data(), io::ColumnMajor) ;
+     check("binary : column-major load", equals(DenseMatrix<double>(fc), ref, rows, cols)) ;
+
+     // zero-copy mapping ,  row-major and column-major
+     {
+        MappedMatrix<double> m(f) , mc(fc) ;
+        const auto p = reinterpret_cast<std::uintptr_t>(m.data()) ;
+        check("MappedMatrix : values in place , 64-byte aligned",
+              m.isRowMajor() && p % 64 == 0 && equals(m, ref, rows, cols) && m.data()[rows*cols-1] == ref.back()) ;
+        check("MappedMatrix : column-major file", !mc.isRowMajor() && equals(mc, ref, rows, cols)) ;
+        DenseMatrix<double> b = m * 2.0 + mc ;
+        bool ok = b.size1() == rows && b.size2() == cols ;
+        for(std::size_t i=1 ; ok && i <= rows ; i++)
+           for(std::size_t j=1 ; j <= cols ; j++)
+                 ok = ok && b(i,j) == 3.0 * ref[(i-1)*cols + j-1] ;
+        check("MappedMatrix : in an expression", ok) ;
+     }
+     std::remove(fc.c_str()) ;
+
+     patchHeader(f, [](io::BinaryHeader& h){ h.version = 2 ; }) ;
+     check("binary : unknown version throws OpeningFileException",
+           throws<OpeningFileException>([&]{ DenseMatrix<double> b(f) ; })) ;
+
+     patchHeader(f, [](io::BinaryHeader& h){ h.version = 1 ; h.rows = std::uint64_t(1) << 33 ; h.cols = std::uint64_t(1) << 31 ; }) ;
+     check("binary : overflowing rows x cols throws InvalidSizeException",
+           throws<InvalidSizeException>([&]{ DenseMatrix<double> b(f) ; })) ;
+     check("binary : MappedMatrix checks the header too",
+           throws<InvalidSizeException>([&]{ MappedMatrix<double> b(f) ; })) ;
+
+     patchHeader(f, [&](io::BinaryHeader& h){ h.rows = rows ; h.cols = cols ; }) ;
+     std::filesystem::resize_file(f, std::filesystem::file_size(f) - 1) ;
+     check("binary : truncated file throws InvalidSizeException",
+           throws<InvalidSizeException>([&]{ DenseMatrix<double> b(f) ; })) ;
+     std::remove(f.c_str()) ;
+  }
+
+  std::remove((tmp + ".dat").c_str()) ;
+  return checkSummary("MatrixIO") ;
+}
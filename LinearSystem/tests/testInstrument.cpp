@@ -0,0 +1,147 @@
+# include <cctype>
+# include <chrono>
+# include <sstream>
+# include <string>
+# include <thread>
+# include "../DenseMatrix.H"
+# include "Check.H"
+
+# ifndef MG_INSTRUMENT
+#   error "testInstrument is built with -DMG_INSTRUMENT"
+# endif
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+// recursive descent JSON validator :  true if [p,end) holds exactly one value
+class Json {
+
+   public:
+
+      explicit Json(const std::string& s) : p{s.data()} , end{s.data() + s.size()} {}
+
+      bool valid() { return value() && (blank() , p == end) ; }
+
+   private:
+
+      void blank() { while(p < end && std::isspace(static_cast<unsigned char>(*p))) p++ ; }
+
+      bool eat(const char c) { blank() ; if(p < end && *p == c) { p++ ; return true ; } return false ; }
+
+      bool value()
+      {
+         blank() ;
+         if(p == end) return false ;
+         if(*p == '{') return object() ;
+         if(*p == '[') return array() ;
+         if(*p == '"') return string() ;
+         return number() ;
+      }
+
+      bool object()
+      {
+         p++ ;
+         if(eat('}')) return true ;
+         do { if(!(blank() , string()) || !eat(':') || !value()) return false ; } while(eat(',')) ;
+         return eat('}') ;
+      }
+
+      bool array()
+      {
+         p++ ;
+         if(eat(']')) return true ;
+         do { if(!value()) return false ; } while(eat(',')) ;
+         return eat(']') ;
+      }
+
+      bool string()
+      {
+         if(p == end || *p != '"') return false ;
+         for(p++ ; p < end && *p != '"' ; p++)
+               if(*p == '\\' || static_cast<unsigned char>(*p) < 0x20) return false ;   // no escapes are written
+         return p < end && *p++ == '"' ;
+      }
+
+      bool number()
+      {
+         const char* b = p ;
+         if(p < end && *p == '-') p++ ;
+         while(p < end && (std::isdigit(static_cast<unsigned char>(*p)) || *p == '.' || *p == 'e' || *p == 'E' ||
+                           *p == '+' || *p == '-')) p++ ;
+         return p > b && std::isdigit(static_cast<unsigned char>(p[-1])) ;
+      }
+
+      const char* p ;
+      const char* end ;
+};
+
+
+int main(){
+
+  using instrument::Registry ;
+
+  instrument::reset() ;
+
+  // two profiled scopes of the same name
+  for(int r=0 ; r < 2 ; r++)
+  {
+     MG_PROFILE("test::sleep", 100, 800) ;
+     std::this_thread::sleep_for(std::chrono::milliseconds(2)) ;
+  }
+  {
+     const auto k = Registry::get().kernels() ;
+     const auto it = k.find("test::sleep") ;
+     check("scope : recorded", it != k.end()) ;
+     if(it != k.end())
+     {
+        const auto& c = it->second ;
+        check("scope : 2 calls", c.calls == 2) ;
+        check("scope : time >= 4 ms", c.seconds >= 0.004) ;
+        check("scope : flops and bytes summed", c.flops == 200 && c.bytes == 1600) ;
+     }
+  }
+
+  // the hooks of the library
+  {
+     DenseMatrix<double> A(64, 64) , B(64, 64) ;
+     A += B ;
+     A += B ;
+     const auto k = Registry::get().kernels() ;
+     const auto it = k.find("DenseMatrix::operator+=") ;
+     check("library kernel : calls and nonzero time",
+           it != k.end() && it->second.calls == 2 && it->second.seconds > 0 && it->second.flops == 2*64*64) ;
+  }
+
+  // allocations
+  {
+     const auto n = Registry::get().allocations() , bytes = Registry::get().allocatedBytes() ;
+     MG_COUNT_ALLOC(100) ;
+     MG_COUNT_ALLOC(28) ;
+     check("allocations counted", Registry::get().allocations() == n + 2 && Registry::get().allocatedBytes() == bytes + 128) ;
+  }
+
+  // reports
+  {
+     std::ostringstream table , json ;
+     instrument::report(table) ;
+     instrument::report(json, true) ;
+     check("table report : header and kernels",
+           table.str().find("GFLOP/s") != std::string::npos && table.str().find("test::sleep") != std::string::npos) ;
+     check("JSON report parses", Json(json.str()).valid()) ;
+     check("JSON report : kernels", json.str().find("\"kernel\": \"test::sleep\"") != std::string::npos) ;
+     check("JSON validator rejects a broken report", !Json(json.str().substr(0, json.str().size() - 3)).valid()) ;
+  }
+
+  instrument::reset() ;
+  {
+     std::ostringstream json ;
+     instrument::report(json, true) ;
+     check("reset : no kernels , empty report parses",
+           Registry::get().kernels().empty() && Registry::get().allocations() == 0 && Json(json.str()).valid()) ;
+  }
+
+  return checkSummary("Instrument") ;
+}
@@ -0,0 +1,160 @@
+# include <cmath>
+# include <limits>
+# include <random>
+# include <string>
+# include <vector>
+# include "../Kernels.H"
+# include "Check.H"
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+const std::size_t guard = 16 ;      // values past the end that no kernel may touch
+
+const double sentinel = -12345.0 ;
+
+
+std::vector<double> random(std::size_t n, unsigned seed)
+{
+   std::mt19937 g(seed) ;
+   std::uniform_real_distribution<double> d(-1.0, 1.0) ;
+   std::vector<double> v(n + guard, sentinel) ;
+   for(std::size_t i=0 ; i < n ; i++) v[i] = d(g) ;
+   return v ;
+}
+
+
+// |a - b| <= tol * (|b| + 1) on the first n values ,  the guard values unchanged
+bool same(const std::vector<double>& a, const std::vector<double>& b, std::size_t n, double tol)
+{
+   for(std::size_t i=0 ; i < n ; i++)
+         if(!(std::abs(a[i] - b[i]) <= tol * (std::abs(b[i]) + 1.0))) return false ;
+   for(std::size_t i=n ; i < a.size() ; i++)
+         if(a[i] != sentinel) return false ;
+   return true ;
+}
+
+
+std::string name(const kernel::Isa isa)
+{
+   switch(isa)
+   {
+      case kernel::Isa::AVX512 : return "AVX-512" ;
+      case kernel::Isa::AVX2   : return "AVX2" ;
+      default                  : return "scalar" ;
+   }
+}
+
+
+// every kernel on the active path against kernel::scalar ,  lengths that are not
+// multiples of the register width exercise the scalar and the masked tails
+void compare(const kernel::Isa isa)
+{
+   const std::string p = name(isa) + " : " ;
+   const double eps = std::numeric_limits<double>::epsilon() ;
+   bool axpy = true , scale = true , dot = true , add = true , sub = true , gemv = true ;
+
+   for(const std::size_t n : {0, 1, 3, 4, 5, 7, 8, 9, 13, 15, 16, 17, 31, 33, 1023})
+   {
+      const auto x = random(n, 1) , y = random(n, 2) ;
+      const double a = 0.7 ;
+
+      auto r = y , s = y ;
+      kernel::axpy(n, a, x.data(), r.data()) ;
+      kernel::scalar::axpy(n, a, x.data(), s.data()) ;
+      axpy = axpy && same(r, s, n, 4*eps) ;                 // FMA : one rounding less
+
+      r = x ; s = x ;
+      kernel::scale(n, a, r.data()) ;
+      kernel::scalar::scale(n, a, s.data()) ;
+      scale = scale && same(r, s, n, 0.0) ;
+
+      const double d = kernel::dot(n, x.data(), y.data()) , e = kernel::scalar::dot(n, x.data(), y.data()) ;
+      dot = dot && std::abs(d - e) <= 4*eps*n ;             // summation order differs
+
+      r.assign(n + guard, sentinel) ; s = r ;
+      kernel::add(n, x.data(), y.data(), r.data()) ;
+      kernel::scalar::add(n, x.data(), y.data(), s.data()) ;
+      add = add && same(r, s, n, 0.0) ;
+
+      r.assign(n + guard, sentinel) ; s = r ;
+      kernel::sub(n, x.data(), y.data(), r.data()) ;
+      kernel::scalar::sub(n, x.data(), y.data(), s.data()) ;
+      sub = sub && same(r, s, n, 0.0) ;
+
+      // gemv : 1 to 9 rows (blocks of 4 plus the remainder) , padded leading dimension
+      for(std::size_t m=1 ; m <= 9 ; m++)
+      {
+         const std::size_t lda = n + 3 ;
+         const auto A = random(m*lda, 3) ;
+         r.assign(m + guard, sentinel) ; s = r ;
+         kernel::gemv(m, n, A.data(), lda, x.data(), r.data()) ;
+         kernel::scalar::gemv(m, n, A.data(), lda, x.data(), s.data()) ;
+         gemv = gemv && same(r, s, m, 4*eps*(n+1)) ;
+      }
+   }
+   check(p + "axpy" , axpy) ;
+   check(p + "scale", scale) ;
+   check(p + "dot"  , dot) ;
+   check(p + "add"  , add) ;
+   check(p + "sub"  , sub) ;
+   check(p + "gemv" , gemv) ;
+}
+
+
+int main(){
+
+  const kernel::Isa best = kernel::detectIsa() ;
+  std::cout << "CPU : " << name(best) << std::endl ;
+
+  for(const kernel::Isa isa : {kernel::Isa::Scalar, kernel::Isa::AVX2, kernel::Isa::AVX512})
+  {
+     kernel::setIsa(isa) ;
+     if(static_cast<int>(isa) > static_cast<int>(best))
+     {
+        check("setIsa(" + name(isa) + ") falls back to " + name(best), kernel::activeIsa() == best) ;
+        continue ;
+     }
+     check("setIsa(" + name(isa) + ")", kernel::activeIsa() == isa) ;
+     compare(isa) ;
+  }
+  kernel::setIsa(best) ;
+
+  // other value types take the scalar templates
+  {
+     std::vector<float> x{1, 2, 3, 4, 5, 6, 7} , y(7, 1.0f) ;
+     kernel::axpy(x.size(), 2.0f, x.data(), y.data()) ;
+     check("float axpy", y[0] == 3.0f && y[6] == 15.0f && kernel::dot(x.size(), x.data(), x.data()) == 140.0f) ;
+  }
+
+  // threadRange : whole cache lines , the slices cover [0,n) once
+  {
+     std::size_t b , e ;
+     kernel::threadRange(1000, b, e) ;
+     check("threadRange outside a parallel region", b == 0 && e == 1000) ;
+
+     std::vector<std::size_t> first(3, 0) , last(3, 0) ;
+# pragma omp parallel num_threads(3)
+     {
+        std::size_t t = 0 ;
+# ifdef _OPENMP
+        t = static_cast<std::size_t>(omp_get_thread_num()) ;
+# endif
+        kernel::threadRange(1001, first[t], last[t]) ;
+     }
+     bool cover = true ;
+     std::size_t next = 0 ;
+     for(std::size_t t=0 ; t < 3 ; t++)
+     {
+        if(last[t] == 0) continue ;          // fewer threads than asked
+        cover = cover && first[t] == next && first[t] % 8 == 0 ;
+        next = last[t] ;
+     }
+     check("threadRange : cache-line slices covering [0,n) once", cover && next == 1001) ;
+  }
+
+  return checkSummary("Kernels") ;
+}
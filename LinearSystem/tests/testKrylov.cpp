@@ -0,0 +1,137 @@
+# include <cmath>
+# include <vector>
+# include "../Iterative/Krylov.H"
+# include "Check.H"
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+// N x N grid :  5-point Laplacian (SPD) plus  c * first-order upwind convection (nonsymmetric for c > 0)
+SparseMatrix<double> grid(std::size_t N, double c)
+{
+   std::vector<std::size_t> I, J ;
+   std::vector<double> V ;
+   auto add = [&](std::size_t i, std::size_t j, double v){ I.push_back(i); J.push_back(j); V.push_back(v); } ;
+
+   for(std::size_t r=0 ; r < N ; r++){
+      for(std::size_t s=0 ; s < N ; s++){
+         const std::size_t k = r*N + s ;
+         add(k, k, 4.0 + c) ;
+         if(r > 0)   add(k, k-N, -1.0) ;
+         if(r < N-1) add(k, k+N, -1.0) ;
+         if(s > 0)   add(k, k-1, -1.0 - c) ;
+         if(s < N-1) add(k, k+1, -1.0) ;
+      }
+   }
+   return SparseMatrix<double>(N*N, N*N, I, J, V) ;
+}
+
+
+// ||b - A x|| / ||b||  computed here , not by the solver
+double trueResidual(const SparseMatrix<double>& A, const std::vector<double>& b, const std::vector<double>& x)
+{
+   const auto y = A * x ;
+   double r = 0 , nb = 0 ;
+   for(std::size_t i=0 ; i < b.size() ; i++) { r += (b[i] - y[i])*(b[i] - y[i]) ; nb += b[i]*b[i] ; }
+   return std::sqrt(r / nb) ;
+}
+
+
+void converges(const std::string& name, const SolverInfo<double>& info, const SparseMatrix<double>& A,
+               const std::vector<double>& b, const std::vector<double>& x, const double tol)
+{
+   check(name + " converges (" + to_string(info.iterations) + " it.)",
+         info.converged && info.residual <= tol && trueResidual(A, b, x) <= 10*tol &&
+         info.history.size() == info.iterations + 1) ;
+}
+
+
+int main(){
+
+  const double tol = 1.0e-9 ;
+  SolverControl<double> ctl ;
+  ctl.tol = tol ;
+
+  // SPD
+  {
+     const SparseMatrix<double> A = grid(32, 0.0) ;
+     std::vector<double> b(A.size1()) ;
+     for(std::size_t i=0 ; i < b.size() ; i++) b[i] = std::sin(0.1*i) + 1.0 ;
+
+     JacobiPreconditioner<double> jacobi(A) ;
+     ILU0Preconditioner<double>   ilu(A) ;
+     std::vector<double> x ;
+
+     x.clear() ; converges("CG"                , cg(A, b, x, IdentityPreconditioner{}, ctl), A, b, x, tol) ;
+     x.clear() ; converges("CG + Jacobi"       , cg(A, b, x, jacobi, ctl), A, b, x, tol) ;
+     x.clear() ; const auto plain = cg(A, b, x, IdentityPreconditioner{}, ctl) ;
+     x.clear() ; const auto pre   = cg(A, b, x, ilu, ctl) ;
+     converges("CG + ILU(0)", pre, A, b, x, tol) ;
+     check("ILU(0) reduces the CG iterations", pre.iterations < plain.iterations) ;
+     x.clear() ; converges("BiCGSTAB + ILU(0)" , bicgstab(A, b, x, ilu, ctl), A, b, x, tol) ;
+     x.clear() ; converges("GMRES(30) + ILU(0)", gmres(A, b, x, ilu, ctl), A, b, x, tol) ;
+
+     // warm start from the solution : no iteration
+     const auto again = cg(A, b, x, ilu, ctl) ;
+     check("initial guess = solution : 0 iterations", again.converged && again.iterations == 0) ;
+
+     // matrix-free operators (in place and returning)
+     auto inPlace = [&A](const std::vector<double>& v, std::vector<double>& y){ multiply(A, v, y) ; } ;
+     auto byValue = [&A](const std::vector<double>& v){ return A * v ; } ;
+     x.clear() ; converges("CG , in place lambda"      , cg(inPlace, b, x, jacobi, ctl), A, b, x, tol) ;
+     x.clear() ; converges("GMRES(30) , returning lambda", gmres(byValue, b, x, ilu, ctl), A, b, x, tol) ;
+
+     // b = 0
+     std::vector<double> zero(b.size(), 0.0) ;
+     x.assign(b.size(), 1.0) ;
+     const auto z = cg(A, zero, x, jacobi, ctl) ;
+     bool allZero = true ;
+     for(const auto v : x) allZero = allZero && v == 0.0 ;
+     check("b = 0 : x = 0 without iterations", z.converged && z.iterations == 0 && allZero) ;
+
+     x.assign(b.size() + 1, 0.0) ;
+     check("initial guess of the wrong size throws InvalidSizeException",
+           throws<InvalidSizeException>([&]{ cg(A, b, x, jacobi, ctl) ; })) ;
+  }
+
+  // nonsymmetric
+  {
+     const SparseMatrix<double> A = grid(32, 2.0) ;
+     std::vector<double> b(A.size1(), 1.0) ;
+     ILU0Preconditioner<double> ilu(A) ;
+     std::vector<double> x ;
+
+     x.clear() ; converges("nonsymmetric BiCGSTAB"         , bicgstab(A, b, x, IdentityPreconditioner{}, ctl), A, b, x, tol) ;
+     x.clear() ; converges("nonsymmetric BiCGSTAB + ILU(0)", bicgstab(A, b, x, ilu, ctl), A, b, x, tol) ;
+     x.clear() ; converges("nonsymmetric GMRES(30)"        , gmres(A, b, x, IdentityPreconditioner{}, ctl), A, b, x, tol) ;
+     x.clear() ; converges("nonsymmetric GMRES(30) + ILU(0)", gmres(A, b, x, ilu, ctl), A, b, x, tol) ;
+  }
+
+  // ILU(0) zero pivots :  U(2,2) = 1 - 1*1 in the last row , a zero diagonal
+  {
+     const SparseMatrix<double> A(2, 2, {0, 0, 1, 1}, {0, 1, 0, 1}, {1.0, 1.0, 1.0, 1.0}) ;
+     check("ILU(0) zero pivot in the last row throws MatrixException",
+           throws<MatrixException>([&]{ ILU0Preconditioner<double> ilu(A) ; })) ;
+     const SparseMatrix<double> B(1, 1, {0}, {0}, {0.0}) ;
+     check("ILU(0) zero pivot of a 1x1 matrix throws MatrixException",
+           throws<MatrixException>([&]{ ILU0Preconditioner<double> ilu(B) ; })) ;
+  }
+
+  // DenseMatrix operator
+  {
+     DenseMatrix<double> D{ {4, 1, 0} ,
+                            {1, 3, 1} ,
+                            {0, 1, 2} } ;
+     const std::vector<double> b{1, 2, 3} ;
+     std::vector<double> x ;
+     const auto info = cg(D, b, x, IdentityPreconditioner{}, ctl) ;
+     const auto y = D * x ;
+     check("CG on a DenseMatrix", info.converged && info.iterations <= 3 &&
+           std::abs(y[0] - 1) < 1e-8 && std::abs(y[1] - 2) < 1e-8 && std::abs(y[2] - 3) < 1e-8) ;
+  }
+
+  return checkSummary("Krylov") ;
+}
@@ -0,0 +1,121 @@
+# include <cmath>
+# include <random>
+# include <vector>
+# include "../DenseMatrix.H"
+# include "../LUFactor.H"
+# include "Check.H"
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+// max_i |(A x - b)_i| / (max|A| * max|x| * n)
+double residual(const DenseMatrix<double>& a, const std::vector<double>& x, const std::vector<double>& b)
+{
+   const std::size_t n = a.size1() ;
+   double r = 0 , na = 0 , nx = 0 ;
+   for(std::size_t i=1 ; i <= n ; i++)
+   {
+      double s = -b[i-1] ;
+      for(std::size_t j=1 ; j <= n ; j++)
+      {
+         s += a(i,j) * x[j-1] ;
+         na = std::max(na, std::abs(a(i,j))) ;
+      }
+      r  = std::max(r, std::abs(s)) ;
+      nx = std::max(nx, std::abs(x[i-1])) ;
+   }
+   return r / (na * nx * n) ;
+}
+
+
+DenseMatrix<double> random(std::size_t n, unsigned seed)
+{
+   std::mt19937 g(seed) ;
+   std::uniform_real_distribution<double> d(-1.0, 1.0) ;
+   DenseMatrix<double> a(n, n) ;
+   for(std::size_t i=1 ; i <= n ; i++)
+      for(std::size_t j=1 ; j <= n ; j++)
+            a(i,j) = d(g) ;
+   return a ;
+}
+
+
+int main(){
+
+  // known system , det = -16 , x = (1 2 3)
+  {
+     DenseMatrix<double> a{ { 2,  1, 1} ,
+                            { 4, -6, 0} ,
+                            {-2,  7, 2} } ;
+     LUFactor<double> f{a} ;
+     const auto x = f.solve(std::vector<double>{7, -8, 18}) ;
+     check("3x3 det", std::abs(f.det() + 16.0) < 1e-13) ;
+     check("3x3 solve", std::abs(x[0] - 1) < 1e-13 && std::abs(x[1] - 2) < 1e-13 && std::abs(x[2] - 3) < 1e-13) ;
+  }
+
+  // zero leading pivot : needs a row swap
+  {
+     DenseMatrix<double> a{ {0, 1} ,
+                            {1, 0} } ;
+     LUFactor<double> f{a} ;
+     const auto x = f.solve(std::vector<double>{2, 3}) ;
+     check("pivoting : not singular", !f.isSingular()) ;
+     check("pivoting : row 1 swapped with row 2", f.pivots()[0] == 1) ;
+     check("pivoting : det = -1", f.det() == -1.0) ;
+     check("pivoting : solve", x[0] == 3.0 && x[1] == 2.0) ;
+  }
+
+  // singular matrix
+  {
+     DenseMatrix<double> a{ {1, 2, 3} ,
+                            {2, 4, 6} ,
+                            {1, 0, 1} } ;
+     LUFactor<double> f{a} ;
+     check("singular : detected", f.isSingular()) ;
+     check("singular : det = 0", f.det() == 0.0) ;
+     check("singular : solve throws MatrixException",
+           throws<MatrixException>([&]{ f.solve(std::vector<double>{1, 1, 1}) ; })) ;
+  }
+
+  // larger than the tile (64) : tiled task factorization , one and many rhs
+  for(const std::size_t n : {5, 64, 65, 300})
+  {
+     const auto a = random(n, n) ;
+     LUFactor<double> f{a} ;
+
+     std::vector<double> b(n) ;
+     for(std::size_t i=0 ; i < n ; i++) b[i] = std::sin(double(i)) ;
+     const auto x = f.solve(b) ;
+     check("n = " + to_string(n) + " : solve residual", residual(a, x, b) < 1e-14) ;
+
+     // scaling a row scales the determinant
+     DenseMatrix<double> s{a} ;
+     for(std::size_t j=1 ; j <= n ; j++) s(1,j) *= 2.0 ;
+     check("n = " + to_string(n) + " : det is linear in a row",
+           std::abs(LUFactor<double>{s}.det() - 2.0*f.det()) <= 1e-10 * std::abs(f.det())) ;
+
+     // batch of rhs as the columns of a matrix
+     const std::size_t nrhs = 7 ;
+     DenseMatrix<double> B(n, nrhs) ;
+     for(std::size_t i=1 ; i <= n ; i++) for(std::size_t j=1 ; j <= nrhs ; j++) B(i,j) = std::cos(double(i*j)) ;
+     const auto X = f.solve(B) ;
+     bool ok = true ;
+     for(std::size_t j=1 ; j <= nrhs ; j++)
+     {
+        std::vector<double> xj(n) , bj(n) ;
+        for(std::size_t i=1 ; i <= n ; i++) { xj[i-1] = X(i,j) ; bj[i-1] = B(i,j) ; }
+        ok = ok && residual(a, xj, bj) < 1e-14 ;
+     }
+     check("n = " + to_string(n) + " : " + to_string(nrhs) + " rhs residual", ok) ;
+  }
+
+  check("non-square matrix throws InvalidSizeException",
+        throws<InvalidSizeException>([]{ LUFactor<double> f{DenseMatrix<double>(3, 4)} ; })) ;
+  check("rhs of the wrong size throws InvalidSizeException",
+        throws<InvalidSizeException>([]{ LUFactor<double>{random(4, 1)}.solve(std::vector<double>(3, 1.0)) ; })) ;
+
+  return checkSummary("LUFactor") ;
+}
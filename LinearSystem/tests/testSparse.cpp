@@ -0,0 +1,122 @@
+# include <cmath>
+# include <cstdio>
+# include <fstream>
+# include <random>
+# include <vector>
+# include "../SparseMatrix.H"
+# include "Check.H"
+
+
+using namespace std;
+
+using namespace mg::numeric::algebra ;
+
+
+double maxDiff(const std::vector<double>& a, const std::vector<double>& b)
+{
+   if(a.size() != b.size()) return 1e300 ;
+   double d = 0 ;
+   for(std::size_t i=0 ; i < a.size() ; i++) d = std::max(d, std::abs(a[i] - b[i])) ;
+   return d ;
+}
+
+
+// y = A x  and  y = A^T x  by the dense loops
+std::vector<double> denseMult(const DenseMatrix<double>& a, const std::vector<double>& x, bool trans)
+{
+   std::vector<double> y(trans ? a.size2() : a.size1(), 0.0) ;
+   for(std::size_t i=1 ; i <= a.size1() ; i++)
+      for(std::size_t j=1 ; j <= a.size2() ; j++)
+      {
+         if(trans) y[j-1] += a(i,j) * x[i-1] ;
+         else      y[i-1] += a(i,j) * x[j-1] ;
+      }
+   return y ;
+}
+
+
+void write(const std::string& fname, const std::string& text)
+{
+   std::ofstream f(fname) ;
+   f << text ;
+}
+
+
+int main(){
+
+  // duplicates (summed) , unsorted columns , an empty row
+  {
+     SparseMatrix<double> s(3, 4, {2, 0, 2, 0, 2, 0}, {3, 1, 0, 1, 3, 0}, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0}) ;
+     const std::vector<std::size_t> ptr{0, 2, 2, 4} , ind{0, 1, 0, 3} ;
+     const std::vector<double> val{6.0, 6.0, 3.0, 6.0} ;
+     check("CSR arrays with duplicates summed and sorted rows",
+           s.rowPointer() == ptr && s.colIndex() == ind && s.values() == val) ;
+     check("operator() on stored and missing entries", s(1,2) == 6.0 && s(3,4) == 6.0 && s(2,2) == 0.0) ;
+  }
+
+  check("coordinate out of range throws InvalidCoordinateException",
+        throws<InvalidCoordinateException>([]{ SparseMatrix<double> s(2, 2, {0, 2}, {0, 0}, {1.0, 1.0}) ; })) ;
+  check("coordinate arrays of different length throw InvalidSizeException",
+        throws<InvalidSizeException>([]{ SparseMatrix<double> s(2, 2, {0, 1}, {0}, {1.0, 1.0}) ; })) ;
+
+  // random rectangular matrix : SpMV and A^T x against the dense loops
+  {
+     const std::size_t m = 700 , n = 500 ;
+     std::mt19937 g(7) ;
+     std::uniform_int_distribution<std::size_t> ri(0, m-1) , ci(0, n-1) ;
+     std::uniform_real_distribution<double> d(-1.0, 1.0) ;
+     std::vector<std::size_t> I , J ;
+     std::vector<double> V ;
+     for(std::size_t k=0 ; k < 6000 ; k++) { I.push_back(ri(g)) ; J.push_back(ci(g)) ; V.push_back(d(g)) ; }
+
+     SparseMatrix<double> s(m, n, I, J, V) ;
+     const DenseMatrix<double> a = s.toDense() ;
+
+     std::vector<double> x(n) , xt(m) ;
+     for(auto& v : x)  v = d(g) ;
+     for(auto& v : xt) v = d(g) ;
+
+     check("SpMV operator*", maxDiff(s * x, denseMult(a, x, false)) < 1e-13) ;
+     std::vector<double> y ;
+     multiply(s, x, y) ;
+     check("SpMV multiply", maxDiff(y, denseMult(a, x, false)) < 1e-13) ;
+
+     check("transMult without CSC", maxDiff(transMult(s, xt), denseMult(a, xt, true)) < 1e-13) ;
+     s.buildCSC() ;
+     check("transMult with CSC", s.hasCSC() && maxDiff(transMult(s, xt), denseMult(a, xt, true)) < 1e-13) ;
+     check("transpose() * x = A^T x", maxDiff(s.transpose() * xt, denseMult(a, xt, true)) < 1e-13) ;
+
+     const SparseMatrix<double> back(a) ;
+     check("DenseMatrix -> SparseMatrix round trip", back.nonZeros() == s.nonZeros() && maxDiff(back * x, s * x) == 0.0) ;
+  }
+
+  // files : MatrixMarket general / symmetric / pattern , plain text
+  {
+     const std::string fname = "testSparse_tmp.mtx" , dname = "testSparse_tmp.dat" ;
+
+     write(fname, "%%MatrixMarket matrix coordinate real general\n% comment\n3 3 4\n1 1 2.5\n3 1 -1\n2 2 4\n3 3 1e1\n") ;
+     SparseMatrix<double> g(fname) ;
+     check("MatrixMarket general", g.nonZeros() == 4 && g(1,1) == 2.5 && g(3,1) == -1.0 && g(1,3) == 0.0 && g(3,3) == 10.0) ;
+
+     write(fname, "%%MatrixMarket matrix coordinate real symmetric\n3 3 3\n1 1 2\n3 1 -1\n2 2 4\n") ;
+     SparseMatrix<double> sym(fname) ;
+     check("MatrixMarket symmetric", sym.nonZeros() == 4 && sym(3,1) == -1.0 && sym(1,3) == -1.0) ;
+
+     write(fname, "%%MatrixMarket matrix coordinate pattern general\n2 3 2\n1 3\n2 1\n") ;
+     SparseMatrix<double> pat(fname) ;
+     check("MatrixMarket pattern", pat.size1() == 2 && pat.size2() == 3 && pat(1,3) == 1.0 && pat(2,1) == 1.0) ;
+
+     write(fname, "%%MatrixMarket matrix coordinate real general\n3 3 2\n1 1 2\n2 3\n") ;
+     check("MatrixMarket entry without value throws OpeningFileException",
+           throws<OpeningFileException>([&]{ SparseMatrix<double> s(fname) ; })) ;
+
+     write(dname, "2 0 0\n0 0 -1\n0 4 0\n") ;
+     SparseMatrix<double> dat(dname) ;
+     check("plain text file", dat.nonZeros() == 3 && dat(1,1) == 2.0 && dat(2,3) == -1.0 && dat(3,2) == 4.0) ;
+
+     std::remove(fname.c_str()) ;
+     std::remove(dname.c_str()) ;
+  }
+
+  return checkSummary("SparseMatrix") ;
+}